@@ -11,6 +11,9 @@
 #include <time.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <openssl/ssl.h>
 #include <openssl/err.h>
 
@@ -21,6 +24,11 @@
 #define TIMEOUT_SECS 10
 #define MAX_DAYS 7
 #define MAX_STATIONS 150
+#define ARCHIVE_FILE "weather.wxa"
+#define INDEX_FILE "weather.wxi"
+#define ARCHIVE_MAGIC "WXARCHV1"
+#define INDEX_MAGIC "WXINDEX1"
+#define ARCHIVE_VERSION 1
 
 typedef struct {
     char code[16];      // ICAO code
@@ -46,6 +54,61 @@ typedef struct {
     int count;
 } WeatherHistory;
 
+// Fixed-size archive record, written as-is so readers can use it straight from mmap.
+// Text fields match the sizes in Station and WeatherData so nothing is cut off.
+typedef struct {
+    char code[16];          // ICAO code
+    char mode[16];          // AUTO or MAN
+    int32_t date_key;       // YYYYMMDD
+    float temperature;
+    float dew_point;
+    int32_t humidity;
+    float wind_speed;
+    int32_t wind_direction;
+    float visibility;
+    int32_t snow_depth;
+    char date[16];
+    char datetime[64];
+    char station[256];
+} ArchiveRecord;
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+} ArchiveHeader;
+
+// Index entries are sorted by station code, mode, then date
+typedef struct {
+    char code[16];
+    char mode[16];
+    int32_t date_key;
+    uint32_t record;        // Position of the record in the archive
+} IndexEntry;
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_count;  // Archive records covered by this index
+    uint64_t archive_size;  // Archive file size when the index was built
+    uint32_t checksum;      // Checksum of the archive header and first/last records
+    uint32_t reserved;
+} IndexHeader;
+
+typedef struct {
+    void *base;
+    size_t size;
+    const ArchiveRecord *records;
+    uint32_t count;
+} ArchiveMap;
+
+typedef struct {
+    void *base;
+    size_t size;
+    const IndexEntry *entries;
+    uint32_t count;
+} IndexMap;
+
 // Clear the terminal for a fresh screen
 static void clear_screen(void) {
     printf("\033[2J\033[H");
@@ -447,6 +510,382 @@ void print_weather_table(WeatherHistory history) {
     printf("└──────────────┴────────┴──────────┴──────────┴──────────┘\n");
 }
 
+// Convert a YYYY-MM-DD date into a sortable YYYYMMDD key, 0 if malformed
+static int32_t date_key(const char *date) {
+    int year, month, day, len = 0;
+    if (sscanf(date, "%4d-%2d-%2d%n", &year, &month, &day, &len) != 3 || date[len] != '\0') return 0;
+    if (year < 1 || month < 1 || month > 12 || day < 1 || day > 31) return 0;
+    return year * 10000 + month * 100 + day;
+}
+
+// Days since 1970-01-01 for a YYYYMMDD key, used to measure calendar spans
+static long day_number(int32_t key) {
+    long year = key / 10000;
+    long month = key / 100 % 100;
+    long day = key % 100;
+
+    year -= month <= 2;
+    long era = (year >= 0 ? year : year - 399) / 400;
+    long yoe = year - era * 400;
+    long doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+// FNV-1a checksum, chained through hash so several regions can be combined
+static uint32_t checksum(uint32_t hash, const void *data, size_t len) {
+    const unsigned char *p = data;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= p[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Checksum the archive header and its first and last records, cheap enough to run on every open
+static uint32_t archive_checksum(const ArchiveMap *am) {
+    uint32_t hash = checksum(2166136261u, am->base, sizeof(ArchiveHeader));
+    if (am->count > 0) {
+        hash = checksum(hash, &am->records[0], sizeof(ArchiveRecord));
+        hash = checksum(hash, &am->records[am->count - 1], sizeof(ArchiveRecord));
+    }
+    return hash;
+}
+
+// Map a whole file read-only
+static int map_file(const char *path, void **base, size_t *size) {
+    struct stat st;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+
+    if (fstat(fd, &st) < 0 || st.st_size == 0) {
+        close(fd);
+        return -1;
+    }
+
+    void *p = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) return -1;
+
+    *base = p;
+    *size = st.st_size;
+    return 0;
+}
+
+// Map the observation archive; a trailing partial record is ignored
+static int archive_open(ArchiveMap *am) {
+    if (map_file(ARCHIVE_FILE, &am->base, &am->size) < 0) return -1;
+
+    const ArchiveHeader *hdr = am->base;
+    if (am->size < sizeof(ArchiveHeader) ||
+        memcmp(hdr->magic, ARCHIVE_MAGIC, sizeof(hdr->magic)) != 0 ||
+        hdr->version != ARCHIVE_VERSION ||
+        hdr->record_size != sizeof(ArchiveRecord)) {
+        munmap(am->base, am->size);
+        return -1;
+    }
+
+    am->records = (const ArchiveRecord *)((const char *)am->base + sizeof(ArchiveHeader));
+    am->count = (am->size - sizeof(ArchiveHeader)) / sizeof(ArchiveRecord);
+    return 0;
+}
+
+static void archive_close(ArchiveMap *am) {
+    munmap(am->base, am->size);
+}
+
+// Map the index, rejecting it if it was not built from this exact archive
+static int index_open(IndexMap *im, const ArchiveMap *am) {
+    if (map_file(INDEX_FILE, &im->base, &im->size) < 0) return -1;
+
+    const IndexHeader *hdr = im->base;
+    if (im->size < sizeof(IndexHeader) ||
+        memcmp(hdr->magic, INDEX_MAGIC, sizeof(hdr->magic)) != 0 ||
+        hdr->version != ARCHIVE_VERSION ||
+        hdr->record_count != am->count ||
+        hdr->archive_size != am->size ||
+        hdr->checksum != archive_checksum(am) ||
+        (im->size - sizeof(IndexHeader)) / sizeof(IndexEntry) != am->count) {
+        munmap(im->base, im->size);
+        return -1;
+    }
+
+    im->entries = (const IndexEntry *)((const char *)im->base + sizeof(IndexHeader));
+    im->count = am->count;
+    return 0;
+}
+
+static void index_close(IndexMap *im) {
+    munmap(im->base, im->size);
+}
+
+// Order an index entry against a station/date key
+static int index_key_cmp(const IndexEntry *e, const char *code, const char *mode, int32_t key) {
+    int c = strncmp(e->code, code, sizeof(e->code));
+    if (c != 0) return c;
+    c = strncmp(e->mode, mode, sizeof(e->mode));
+    if (c != 0) return c;
+    return (e->date_key > key) - (e->date_key < key);
+}
+
+static int index_entry_cmp(const void *a, const void *b) {
+    const IndexEntry *ea = a;
+    const IndexEntry *eb = b;
+    int c = index_key_cmp(ea, eb->code, eb->mode, eb->date_key);
+    if (c != 0) return c;
+    return (ea->record > eb->record) - (ea->record < eb->record);
+}
+
+// First index position whose key is not less than the given one
+static uint32_t index_lower_bound(const IndexMap *im, const char *code, const char *mode, int32_t key) {
+    uint32_t lo = 0, hi = im->count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (index_key_cmp(&im->entries[mid], code, mode, key) < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// Regenerate the sorted index from the archive, replacing the old one atomically
+static int index_rebuild(const ArchiveMap *am) {
+    IndexHeader hdr = {0};
+    IndexEntry *entries = NULL;
+    char tmp_path[64];
+
+    if (am->count > 0) {
+        entries = malloc(am->count * sizeof(IndexEntry));
+        if (!entries) return -1;
+    }
+
+    for (uint32_t i = 0; i < am->count; i++) {
+        memcpy(entries[i].code, am->records[i].code, sizeof(entries[i].code));
+        memcpy(entries[i].mode, am->records[i].mode, sizeof(entries[i].mode));
+        entries[i].date_key = am->records[i].date_key;
+        entries[i].record = i;
+    }
+    if (am->count > 0) {
+        qsort(entries, am->count, sizeof(IndexEntry), index_entry_cmp);
+    }
+
+    memcpy(hdr.magic, INDEX_MAGIC, sizeof(hdr.magic));
+    hdr.version = ARCHIVE_VERSION;
+    hdr.record_count = am->count;
+    hdr.archive_size = am->size;
+    hdr.checksum = archive_checksum(am);
+
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", INDEX_FILE);
+    FILE *fp = fopen(tmp_path, "wb");
+    if (!fp) {
+        free(entries);
+        return -1;
+    }
+
+    int ok = fwrite(&hdr, sizeof(hdr), 1, fp) == 1 &&
+             (am->count == 0 || fwrite(entries, sizeof(IndexEntry), am->count, fp) == am->count);
+    ok = (fclose(fp) == 0) && ok;
+    free(entries);
+
+    if (!ok || rename(tmp_path, INDEX_FILE) < 0) {
+        unlink(tmp_path);
+        return -1;
+    }
+    return 0;
+}
+
+// Map the index, rebuilding it first if it is missing or stale
+static int index_open_fresh(IndexMap *im, const ArchiveMap *am) {
+    if (index_open(im, am) == 0) return 0;
+    if (index_rebuild(am) < 0) return -1;
+    return index_open(im, am);
+}
+
+// Append fetched observations to the archive, skipping dates already stored
+int archive_append(const Station *station, const WeatherHistory *history) {
+    ArchiveMap am;
+    IndexMap im;
+    struct stat st;
+    int appended = 0;
+
+    int fd = open(ARCHIVE_FILE, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) { perror("open archive"); return -1; }
+
+    if (fstat(fd, &st) < 0) {
+        perror("fstat archive");
+        close(fd);
+        return -1;
+    }
+
+    // A new file, or one whose header write was interrupted, gets a fresh header.
+    // The header covers every byte already there, so no truncation is needed.
+    if ((size_t)st.st_size < sizeof(ArchiveHeader)) {
+        ArchiveHeader hdr = {0};
+        memcpy(hdr.magic, ARCHIVE_MAGIC, sizeof(hdr.magic));
+        hdr.version = ARCHIVE_VERSION;
+        hdr.record_size = sizeof(ArchiveRecord);
+        if (lseek(fd, 0, SEEK_SET) < 0 || write(fd, &hdr, sizeof(hdr)) != sizeof(hdr)) {
+            perror("write archive header");
+            close(fd);
+            return -1;
+        }
+    }
+
+    if (archive_open(&am) < 0) {
+        fprintf(stderr, "%s is not a valid weather archive\n", ARCHIVE_FILE);
+        close(fd);
+        return -1;
+    }
+
+    if (index_open_fresh(&im, &am) < 0) {
+        fprintf(stderr, "Failed to index %s\n", ARCHIVE_FILE);
+        archive_close(&am);
+        close(fd);
+        return -1;
+    }
+
+    // Write after the last whole record, overwriting any partial one an interrupted append left
+    if (lseek(fd, sizeof(ArchiveHeader) + (off_t)am.count * sizeof(ArchiveRecord), SEEK_SET) < 0) {
+        perror("lseek archive");
+        index_close(&im);
+        archive_close(&am);
+        close(fd);
+        return -1;
+    }
+    for (int i = 0; i < history->count; i++) {
+        const WeatherData *wd = &history->data[i];
+        int32_t key = date_key(wd->date);
+        if (key == 0) continue;
+
+        uint32_t pos = index_lower_bound(&im, station->code, station->mode, key);
+        if (pos < im.count && index_key_cmp(&im.entries[pos], station->code, station->mode, key) == 0) {
+            continue;
+        }
+
+        ArchiveRecord rec = {0};
+        snprintf(rec.code, sizeof(rec.code), "%s", station->code);
+        snprintf(rec.mode, sizeof(rec.mode), "%s", station->mode);
+        rec.date_key = key;
+        rec.temperature = wd->temperature;
+        rec.dew_point = wd->dew_point;
+        rec.humidity = wd->humidity;
+        rec.wind_speed = wd->wind_speed;
+        rec.wind_direction = wd->wind_direction;
+        rec.visibility = wd->visibility;
+        rec.snow_depth = wd->snow_depth;
+        snprintf(rec.date, sizeof(rec.date), "%s", wd->date);
+        snprintf(rec.datetime, sizeof(rec.datetime), "%s", wd->datetime);
+        snprintf(rec.station, sizeof(rec.station), "%s", wd->station);
+
+        if (write(fd, &rec, sizeof(rec)) != sizeof(rec)) {
+            perror("write archive record");
+            break;
+        }
+        appended++;
+    }
+
+    index_close(&im);
+    archive_close(&am);
+    close(fd);
+
+    if (appended > 0 && archive_open(&am) == 0) {
+        if (index_rebuild(&am) < 0) {
+            fprintf(stderr, "Failed to update %s\n", INDEX_FILE);
+        }
+        archive_close(&am);
+    }
+
+    return appended;
+}
+
+// Render a window oldest-first, as collected from the index
+static void render_window(WeatherHistory *window) {
+    // The print functions expect the most recent day first
+    for (int i = 0, j = window->count - 1; i < j; i++, j--) {
+        WeatherData tmp = window->data[i];
+        window->data[i] = window->data[j];
+        window->data[j] = tmp;
+    }
+    print_temperature_graph(*window);
+    print_weather_table(*window);
+}
+
+// Render archived observations for a station between two dates, without network access
+int replay_archive(const char *code, const char *mode, const char *from, const char *to) {
+    ArchiveMap am;
+    IndexMap im;
+    WeatherHistory window = {0};
+    int32_t from_key = date_key(from);
+    int32_t to_key = date_key(to);
+    long window_start = 0;
+    int found = 0;
+
+    if (from_key == 0 || to_key == 0 || from_key > to_key) {
+        fprintf(stderr, "Invalid date range %s to %s (expected YYYY-MM-DD)\n", from, to);
+        return 1;
+    }
+
+    if (archive_open(&am) < 0) {
+        fprintf(stderr, "No readable archive at %s\n", ARCHIVE_FILE);
+        return 1;
+    }
+
+    if (index_open_fresh(&im, &am) < 0) {
+        fprintf(stderr, "Failed to index %s\n", ARCHIVE_FILE);
+        archive_close(&am);
+        return 1;
+    }
+
+    clear_screen();
+    printf("Archived data for %s (%s) from %s to %s\n", code, mode, from, to);
+
+    for (uint32_t pos = index_lower_bound(&im, code, mode, from_key); pos < im.count; pos++) {
+        const IndexEntry *e = &im.entries[pos];
+        if (strncmp(e->code, code, sizeof(e->code)) != 0 ||
+            strncmp(e->mode, mode, sizeof(e->mode)) != 0 ||
+            e->date_key > to_key) {
+            break;
+        }
+
+        if (e->record >= am.count) continue;
+
+        // Each graph covers at most MAX_DAYS calendar days from its first observation
+        long day = day_number(e->date_key);
+        if (window.count > 0 && (day - window_start >= MAX_DAYS || window.count == MAX_DAYS)) {
+            render_window(&window);
+            window.count = 0;
+        }
+        if (window.count == 0) window_start = day;
+
+        const ArchiveRecord *rec = &am.records[e->record];
+        WeatherData *wd = &window.data[window.count++];
+        snprintf(wd->station, sizeof(wd->station), "%.*s", (int)sizeof(rec->station) - 1, rec->station);
+        snprintf(wd->date, sizeof(wd->date), "%.*s", (int)sizeof(rec->date) - 1, rec->date);
+        snprintf(wd->datetime, sizeof(wd->datetime), "%.*s", (int)sizeof(rec->datetime) - 1, rec->datetime);
+        wd->temperature = rec->temperature;
+        wd->dew_point = rec->dew_point;
+        wd->humidity = rec->humidity;
+        wd->wind_speed = rec->wind_speed;
+        wd->wind_direction = rec->wind_direction;
+        wd->visibility = rec->visibility;
+        wd->snow_depth = rec->snow_depth;
+        found++;
+    }
+
+    if (window.count > 0) {
+        render_window(&window);
+    }
+    if (found == 0) {
+        printf("No archived observations in this range\n");
+    }
+
+    index_close(&im);
+    archive_close(&am);
+    return 0;
+}
+
 // Menu display and selection with pagination
 int show_menu() {
     int page = 0;
@@ -508,10 +947,19 @@ int show_menu() {
     }
 }
 
-int main() {
+int main(int argc, char *argv[]) {
     int choice;
     char input[10];
     
+    if (argc > 1) {
+        if (argc == 6 && strcmp(argv[1], "--replay") == 0) {
+            return replay_archive(argv[2], argv[3], argv[4], argv[5]);
+        }
+        fprintf(stderr, "Usage: %s [--replay CODE MODE FROM TO]\n", argv[0]);
+        fprintf(stderr, "  e.g. %s --replay CYOW MAN 2026-01-01 2026-01-31\n", argv[0]);
+        return 1;
+    }
+    
     while (1) {
         choice = show_menu();
         
@@ -531,6 +979,9 @@ int main() {
         WeatherHistory history = fetch_historical(selected.code, selected.mode);
         
         if (history.count > 0) {
+            if (archive_append(&selected, &history) < 0) {
+                fprintf(stderr, "Warning: could not archive observations\n");
+            }
             clear_screen();
             print_temperature_graph(history);
             print_weather_table(history);